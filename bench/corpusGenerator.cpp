@@ -0,0 +1,53 @@
+//
+// Created by Matteo Cardinaletti on 19/10/26.
+//
+
+#include "corpusGenerator.h"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+bench::Corpus bench::generate_corpus(const bench::CorpusConfig &config) {
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+    std::mt19937 rng(config.seed);
+    bench::Corpus corpus;
+
+    auto add_keys = [&](const std::string &section_path) {
+        for (size_t k = 0; k < config.keys; k++) {
+            std::string key = "key" + std::to_string(k);
+            corpus.text += key + " = ";
+            for (size_t c = 0; c < config.value_length; c++) {
+                corpus.text.push_back(alphabet[rng() % (sizeof(alphabet) - 1)]);
+            }
+            corpus.text += "\n";
+            corpus.entries.push_back({section_path, key});
+        }
+        corpus.text += "\n";
+    };
+
+    add_keys("");
+    for (size_t s = 0; s < config.sections; s++) {
+        std::string path = "sec" + std::to_string(s);
+        corpus.text += "[" + path + "]\n";
+        add_keys(path);
+
+        // relative nesting, each level goes below the previous one.
+        for (size_t d = 1; d < config.depth; d++) {
+            std::string name = "lvl" + std::to_string(d);
+            path += "." + name;
+            corpus.text += "[." + name + "]\n";
+            add_keys(path);
+        }
+    }
+
+    return corpus;
+}
+
+std::string bench::write_corpus(const bench::Corpus &corpus, const std::string &name) {
+    auto path = std::filesystem::temp_directory_path() / (name + ".ini");
+    std::ofstream file(path);
+    file << corpus.text;
+    return path.string();
+}
@@ -0,0 +1,41 @@
+//
+// Created by Matteo Cardinaletti on 19/10/26.
+//
+
+#ifndef CORPUS_GENERATOR_H
+#define CORPUS_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bench {
+    struct CorpusConfig {
+        // top level sections.
+        size_t sections = 16;
+        // levels of every top level section chain, itself included. each level holds its own keys.
+        size_t depth = 1;
+        size_t keys = 8;
+        size_t value_length = 16;
+        uint32_t seed = 42;
+    };
+
+    struct CorpusEntry {
+        std::string section_path;
+        std::string key;
+    };
+
+    struct Corpus {
+        std::string text;
+        // every property defined inside text.
+        std::vector<CorpusEntry> entries;
+    };
+
+    // same config, same corpus: values come from std::mt19937, which is fully specified.
+    Corpus generate_corpus(const CorpusConfig &config);
+
+    // writes the corpus to a temporary '.ini' file and returns its path.
+    std::string write_corpus(const Corpus &corpus, const std::string &name);
+}
+
+#endif //CORPUS_GENERATOR_H
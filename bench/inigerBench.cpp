@@ -0,0 +1,137 @@
+//
+// Created by Matteo Cardinaletti on 19/10/26.
+//
+#include "benchmark/benchmark.h"
+
+#include <memory>
+#include <vector>
+
+#include "../iniger.h"
+#include "corpusGenerator.h"
+
+// sections, depth, keys, value length.
+static void corpus_args(benchmark::internal::Benchmark *b) {
+    b->Args({4, 1, 8, 16});
+    b->Args({64, 2, 16, 32});
+    b->Args({256, 4, 32, 64});
+}
+
+static bench::CorpusConfig corpus_config(const benchmark::State &state) {
+    bench::CorpusConfig config;
+    config.sections = state.range(0);
+    config.depth = state.range(1);
+    config.keys = state.range(2);
+    config.value_length = state.range(3);
+    return config;
+}
+
+static std::string corpus_name(const benchmark::State &state) {
+    return "iniger_bench_" + std::to_string(state.range(0)) + "_" + std::to_string(state.range(1)) + "_" +
+           std::to_string(state.range(2)) + "_" + std::to_string(state.range(3));
+}
+
+static void BM_Read(benchmark::State &state) {
+    bench::Corpus corpus = bench::generate_corpus(corpus_config(state));
+    std::string path = bench::write_corpus(corpus, corpus_name(state));
+
+    for (auto _ : state) {
+        ini::Object ini = ini::read(path);
+        benchmark::DoNotOptimize(ini);
+    }
+
+    state.SetBytesProcessed(state.iterations() * corpus.text.size());
+    state.counters["properties"] = static_cast<double>(corpus.entries.size());
+}
+BENCHMARK(BM_Read)->Apply(corpus_args);
+
+static void BM_Write(benchmark::State &state) {
+    bench::Corpus corpus = bench::generate_corpus(corpus_config(state));
+    std::string path = bench::write_corpus(corpus, corpus_name(state));
+    ini::Object ini = ini::read(path);
+    ini.set_file_path(bench::write_corpus({}, corpus_name(state) + "_out"));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ini::write(ini, '='));
+    }
+
+    state.SetBytesProcessed(state.iterations() * corpus.text.size());
+}
+BENCHMARK(BM_Write)->Apply(corpus_args);
+
+static void BM_GetPropertyHit(benchmark::State &state) {
+    bench::Corpus corpus = bench::generate_corpus(corpus_config(state));
+    ini::Object ini = ini::read(bench::write_corpus(corpus, corpus_name(state)));
+
+    size_t i = 0;
+    for (auto _ : state) {
+        auto &entry = corpus.entries[i++ % corpus.entries.size()];
+        benchmark::DoNotOptimize(ini::get_property(ini, entry.key, entry.section_path));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetPropertyHit)->Apply(corpus_args);
+
+// misses are reported through std::out_of_range.
+static void BM_GetPropertyMiss(benchmark::State &state) {
+    bench::Corpus corpus = bench::generate_corpus(corpus_config(state));
+    ini::Object ini = ini::read(bench::write_corpus(corpus, corpus_name(state)));
+    std::string missing = "missing";
+
+    size_t i = 0;
+    for (auto _ : state) {
+        auto &entry = corpus.entries[i++ % corpus.entries.size()];
+        try {
+            benchmark::DoNotOptimize(ini::get_property(ini, missing, entry.section_path));
+        } catch (std::out_of_range &e) {
+            benchmark::DoNotOptimize(e);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetPropertyMiss)->Apply(corpus_args);
+
+// every property goes into its own section, so each insertion creates at least one section.
+static void BM_AddPropertyNewSections(benchmark::State &state) {
+    bench::Corpus corpus = bench::generate_corpus(corpus_config(state));
+    std::string value(state.range(3), 'v');
+
+    std::vector<std::string> paths;
+    for (auto &entry : corpus.entries) {
+        paths.push_back(entry.section_path.empty() ? entry.key : entry.section_path + "." + entry.key);
+    }
+
+    for (auto _ : state) {
+        auto ini = std::make_unique<ini::Object>("bench.ini");
+        for (size_t i = 0; i < corpus.entries.size(); i++) {
+            ini::add_property(*ini, corpus.entries[i].key, value, paths[i]);
+        }
+        benchmark::DoNotOptimize(ini);
+
+        state.PauseTiming();
+        ini.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * corpus.entries.size());
+}
+BENCHMARK(BM_AddPropertyNewSections)->Apply(corpus_args);
+
+static void BM_Destruction(benchmark::State &state) {
+    bench::Corpus corpus = bench::generate_corpus(corpus_config(state));
+    std::string path = bench::write_corpus(corpus, corpus_name(state));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto ini = std::make_unique<ini::Object>(ini::read(path));
+        state.ResumeTiming();
+
+        ini.reset();
+    }
+
+    state.SetItemsProcessed(state.iterations() * corpus.entries.size());
+}
+BENCHMARK(BM_Destruction)->Apply(corpus_args);
+
+BENCHMARK_MAIN();
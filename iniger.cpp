@@ -4,7 +4,10 @@
 
 #include "iniger.h"
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <unordered_set>
 
 std::string &to_lower(std::string &str) {
     std::transform(str.begin(), str.end(), str.begin(),
@@ -12,193 +15,327 @@ std::string &to_lower(std::string &str) {
     return str;
 }
 
-typedef enum ini_Token_Type {
-    E_O_F = 0,
-    IDENTIFIER = 1,
-    SEPARATOR = 2,
-    SECTION = 3,
-} ini_Token_Type;
+using ini::detail::ini_Token_Type;
+using enum ini::detail::ini_Token_Type;
+using ini::detail::Access;
+
+using ini_Clock = std::chrono::steady_clock;
+
+// points the subsections of sec to its object, rebuilding their paths if asked.
+void ini_attach(ini::Section &sec, bool paths) {
+    for (auto &kv : Access::subsecs(sec)) {
+        if (paths) Access::path(kv.second) = sec.get_path().empty() ? kv.first : sec.get_path() + "." + kv.first;
+        Access::changes(kv.second) = Access::changes(sec);
+        ini_attach(kv.second, paths);
+    }
+}
+
+ini::Section::Section(ini::Section &&other) : sec_name(std::move(other.sec_name)), path(other.path),
+                                              props(std::move(other.props)), subsecs(std::move(other.subsecs)) {
+    Access::modified(other);
+    ini_attach(*this, false);
+}
+
+ini::Section &ini::Section::operator=(const ini::Section &other) {
+    if (this == &other) return *this;
+
+    // other may live below this section.
+    bool same_path = path == other.path;
+    Section copy(other);
+    sec_name = std::move(copy.sec_name);
+    props = std::move(copy.props);
+    subsecs = std::move(copy.subsecs);
+
+    ini_attach(*this, !same_path);
+    Access::modified(*this);
+    return *this;
+}
+
+ini::Section &ini::Section::operator=(ini::Section &&other) {
+    if (this == &other) return *this;
+
+    // other may live below this section.
+    bool same_path = path == other.path;
+    Access::modified(other);
+    auto name = std::move(other.sec_name);
+    auto moved_props = std::move(other.props);
+    auto moved_subsecs = std::move(other.subsecs);
+
+    sec_name = std::move(name);
+    props = std::move(moved_props);
+    subsecs = std::move(moved_subsecs);
+
+    ini_attach(*this, !same_path);
+    Access::modified(*this);
+    return *this;
+}
+
+ini::Object::Object(std::string file_path) : file_path(std::move(file_path)),
+                                             changes(std::make_unique<uint64_t>(0)) {
+    Access::changes(global) = changes.get();
+    index.version = *changes;
+}
+
+ini::Object::Object(const ini::Object &other) : file_path(other.file_path), global(other.global),
+                                                changes(std::make_unique<uint64_t>(0)) {
+    Access::changes(global) = changes.get();
+    ini_attach(global, false);
+}
+
+ini::Object &ini::Object::operator=(const ini::Object &other) {
+    if (this == &other) return *this;
+
+    if (!changes) {
+        changes = std::make_unique<uint64_t>(0);
+        Access::changes(global) = changes.get();
+    }
+
+    file_path = other.file_path;
+    global = other.global;
+    index = Index();
+    return *this;
+}
+
+// the subsections and the counter don't move, only the global section changes place.
+ini::Object::Object(ini::Object &&other) noexcept : file_path(std::move(other.file_path)),
+                                                    index(std::move(other.index)),
+                                                    changes(std::move(other.changes)) {
+    Access::props(global) = std::move(Access::props(other.global));
+    Access::subsecs(global) = std::move(Access::subsecs(other.global));
+    Access::changes(global) = changes.get();
+
+    Access::changes(other.global) = nullptr;
+    other.index = Index();
+}
+
+ini::Object &ini::Object::operator=(ini::Object &&other) noexcept {
+    if (this == &other) return *this;
+
+    file_path = std::move(other.file_path);
+    Access::props(global) = std::move(Access::props(other.global));
+    Access::subsecs(global) = std::move(Access::subsecs(other.global));
+    index = std::move(other.index);
+    changes = std::move(other.changes);
+    Access::changes(global) = changes.get();
+
+    Access::changes(other.global) = nullptr;
+    other.index = Index();
+    return *this;
+}
+
+// false while the index may miss a change.
+bool ini_index_fresh(const ini::Object &ini) {
+    return ini.get_version() != ini::Index::STALE && ini.get_index().version == ini.get_version();
+}
 
 class ini_Token {
 public:
-    explicit ini_Token(ini_Token_Type type = E_O_F, std::string txt = "") : type(type), txt(std::move(txt)) {}
+    explicit ini_Token(ini_Token_Type type = E_O_F, std::string txt = "", int line = 0, int column = 0)
+            : type(type), txt(std::move(txt)), line(line), column(column) {}
 
     ini_Token_Type type;
     std::string txt;
+    int line;
+    int column;
 };
 
-class ini_Lexer {
-public:
-    explicit ini_Lexer(std::string source, std::string file_path) : source(std::move(source)),
-                                                                    file_path(std::move(file_path)), tokens({}) {}
-
-    std::vector<ini_Token> scan_tokens() {
-        while (!end()) {
-            start = current;
-            if (!scan_token()) {
-                tokens.clear();
-                return {};
-            }
-        }
+ini::Error ini_error(ini::Error_Code code, std::string message, int line = 0, int column = 0) {
+    return ini::Error{code, line, column, std::move(message)};
+}
 
-        return tokens;
-    }
+// heap bytes of a string, 0 while it fits the small string buffer.
+size_t ini_string_heap(const std::string &str) {
+    static const size_t sso_capacity = std::string().capacity();
+    return str.capacity() > sso_capacity ? str.capacity() + 1 : 0;
+}
 
-private:
-    char advance() {
-        return source[current++];
+// next pointer, value and cached hash.
+template<typename Map>
+size_t ini_node_size() {
+    return sizeof(void *) + sizeof(typename Map::value_type) + sizeof(size_t);
+}
+
+template<typename Map>
+size_t ini_buckets_size(const Map &map) {
+#if defined(__GLIBCXX__)
+    // libstdc++ keeps a single bucket inside the map itself.
+    if (map.bucket_count() <= 1) return 0;
+#endif
+    return map.bucket_count() * sizeof(void *);
+}
+
+// what a single insertion created, used by ReadStats.
+struct ini_Insertion {
+    size_t sections = 0;
+    size_t properties = 0;
+
+    // estimated, see ini::ReadStats.
+    size_t allocations = 0;
+    size_t allocated_bytes = 0;
+
+    void count_string(const std::string &str) {
+        size_t heap = ini_string_heap(str);
+        if (heap == 0) return;
+        allocations++;
+        allocated_bytes += heap;
     }
 
-    char peek() {
-        if (end()) return '\0';
-        return source[current];
+    // one node, plus the bucket array when the map had to grow.
+    template<typename Map>
+    void count_node(const Map &map, size_t old_bucket_count) {
+        allocations++;
+        allocated_bytes += ini_node_size<Map>();
+        if (map.bucket_count() != old_bucket_count) {
+            allocations++;
+            allocated_bytes += ini_buckets_size(map);
+        }
     }
+};
 
-    bool scan_token() {
-        char c = advance();
-        switch (c) {
-            case '[':
-                while (peek() != ']' && !end()) advance();
-                if (end()) {
-                    std::cerr << "[ERROR]: unclosed section definition inside '" << file_path << "'\n";
-                    return false;
+template<bool WithStats>
+bool ini_add_property(ini::Object &ini, std::string &key, std::string &value, std::string &section_path,
+                      ini_Insertion &created);
+bool ini_section_add_property(ini::Section &sec, std::string &key, std::string &value);
+
+class ini_Lexer {
+public:
+    explicit ini_Lexer(std::string_view source, std::string file_path) : source(source),
+                                                                         file_path(std::move(file_path)), tokens({}) {}
+
+    template<bool WithStats>
+    std::vector<ini_Token> scan_tokens(ini::ReadStats *stats = nullptr) {
+        ini::detail::Scanner scanner(source);
+        ini::detail::Lexeme lexeme;
+        while (scanner.next(lexeme)) {
+            size_t capacity = tokens.capacity();
+            ini_Token &t = tokens.emplace_back(lexeme.type, std::string(lexeme.txt), lexeme.line, lexeme.column);
+
+            if constexpr (WithStats) {
+                if (tokens.capacity() != capacity) {
+                    stats->estimated_allocations++;
+                    stats->estimated_allocated_bytes += tokens.capacity() * sizeof(ini_Token);
                 }
-                advance();
-                tokens.emplace_back(SECTION, source.substr(start + 1, current - (start + 1) - 1));
-                break;
-            case '"':
-                while (peek() != '"' && !end()) advance();
-                if (end()) {
-                    std::cerr << "[ERROR]: unclosed string definition inside '" << file_path << "'\n";
-                    return false;
+                if (t.txt.capacity() > std::string().capacity()) {
+                    stats->estimated_allocations++;
+                    stats->estimated_allocated_bytes += t.txt.capacity() + 1;
+                    stats->token_buffer_peak += t.txt.capacity() + 1;
                 }
-                advance();
-                tokens.emplace_back(IDENTIFIER, source.substr(start, current - (start + 1) - 1));
-                break;
-            case ':':
-            case '=':
-                tokens.emplace_back(SEPARATOR, source.substr(start, current - start));
-                break;
-            case ';':
-            case '#':
-                while (peek() != '\n' && !end()) advance();
+            }
+        }
+
+        if constexpr (WithStats) {
+            stats->tokens = tokens.size();
+            stats->token_buffer_peak += tokens.capacity() * sizeof(ini_Token);
+        }
+
+        int line = scanner.get_line();
+        int column = scanner.get_column();
+        switch (scanner.get_error()) {
+            case ini::detail::Scan_Error::NONE:
+                return std::move(tokens);
+            case ini::detail::Scan_Error::UNCLOSED_SECTION:
+                error = ini_error(ini::Error_Code::UNCLOSED_SECTION,
+                                  "unclosed section definition inside '" + file_path + "'", line, column);
                 break;
-            case ' ':
-                // ignore.
+            case ini::detail::Scan_Error::UNCLOSED_STRING:
+                error = ini_error(ini::Error_Code::UNCLOSED_STRING,
+                                  "unclosed string definition inside '" + file_path + "'", line, column);
                 break;
-            case '\n':
-                line++;
+            case ini::detail::Scan_Error::UNEXPECTED_CHARACTER:
+                error = ini_error(ini::Error_Code::UNEXPECTED_CHARACTER,
+                                  "unexpected character '" + std::string(1, scanner.get_char()) + "' found at '" +
+                                  file_path + ":" + std::to_string(line) + "'", line, column);
                 break;
-            default:
-                if (std::isalnum(static_cast<unsigned char>(c))) {
-                    while (std::isalnum(static_cast<unsigned char>(peek())) ||
-                            peek() == '.' || peek() == '_') {
-                        advance();
-                    }
-                    tokens.emplace_back(IDENTIFIER, source.substr(start, current - start));
-                    break;
-                }
-
-                std::cerr << "[ERROR]: unexpected character '" << c << "' found at '" << file_path << ":" << line
-                          << "'\n";
-                return false;
         }
-        return true;
+
+        tokens.clear();
+        return {};
     }
 
-    bool end() {
-        return current >= source.size();
+    [[nodiscard]] const ini::Error &get_error() const {
+        return error;
     }
 
-    const std::string source;
-    std::vector<ini_Token> tokens;
+private:
+    std::string_view source;
     std::string file_path;
-    int line = 1;
-    int start = 0;
-    int current = 0;
+    std::vector<ini_Token> tokens;
+    ini::Error error;
 };
 
 
+template<bool WithStats>
 class ini_Parser {
 public:
-    explicit ini_Parser(std::vector<ini_Token> &tokens) : tokens(tokens) {}
+    explicit ini_Parser(std::vector<ini_Token> &tokens, ini::ReadStats *stats = nullptr) : tokens(tokens), stats(stats) {}
 
     bool parse_tokens(ini::Object &ini) {
-        while (!end()) {
-            if (!parse_token(ini)) return false;
-        }
+        ini::detail::Parser parser(tokens);
+        bool result = parser.parse([&](std::string_view section, std::string_view key, std::string_view value) {
+            return insert(ini, section, key, value);
+        });
 
-        return true;
+        if (!result) report(parser);
+        return result;
     }
 
-private:
-    bool parse_token(ini::Object &ini) {
-        ini_Token &t = advance();
-        switch (t.type) {
-            case IDENTIFIER: {
-                if (!match(SEPARATOR)) {
-                    std::cerr << "[ERROR]: invalid token '" << peek().txt << "' found after '" << t.txt << "'\n";
-                    return false;
-                }
-                advance();
-
-                if (!match(IDENTIFIER)) {
-                    std::cerr << "[ERROR]: invalid token '" << peek().txt << "' found after '" << t.txt << "'\n";
-                    return false;
-                }
-                ini_Token &v = advance();
+    [[nodiscard]] const ini::Error &get_error() const {
+        return error;
+    }
 
-                if (t.txt.contains(';') || t.txt.contains('#')
-                    || t.txt.contains('=') || t.txt.contains(':') || t.txt.contains(' ')) {
-                    std::cerr << "[ERROR]: invalid key identifier '" << t.txt << "', use only alphanumeric characters\n";
-                    return false;
-                }
+private:
+    bool insert(ini::Object &ini, std::string_view section, std::string_view key, std::string_view value) {
+        std::string k(key);
+        std::string v(value);
+        std::string path(section);
+
+        ini_Insertion created;
+        if constexpr (WithStats) {
+            auto begin = ini_Clock::now();
+            bool result = ini_add_property<true>(ini, k, v, path, created);
+            stats->insert_time += ini_Clock::now() - begin;
+            stats->sections += created.sections;
+            stats->properties += created.properties;
+            stats->estimated_allocations += created.allocations;
+            stats->estimated_allocated_bytes += created.allocated_bytes;
+            return result;
+        } else {
+            return ini_add_property<false>(ini, k, v, path, created);
+        }
+    }
 
-                if (!ini::add_property(ini, to_lower(t.txt), v.txt, section_path)) {
-                    std::cerr << "[ERROR]: something happened during '" << t.txt << "' -> '" << v.txt << "' insertion\n";
-                    return false;
-                }
+    void report(const ini::detail::Parser<std::vector<ini_Token>> &parser) {
+        ini_Token &t = tokens[parser.get_subject()];
+        switch (parser.get_error()) {
+            case ini::detail::Parse_Error::MISSING_SEPARATOR:
+            case ini::detail::Parse_Error::MISSING_VALUE: {
+                bool eof = parser.get_position() >= tokens.size();
+                ini_Token &found = eof ? t : tokens[parser.get_position()];
+                error = ini_error(ini::Error_Code::INVALID_TOKEN, "invalid token '" + (eof ? "EOF" : found.txt) +
+                                  "' found after '" + t.txt + "'", found.line, found.column);
             }
                 break;
-            case SECTION:
-                if (!t.txt.starts_with('.')) {
-                    section_path = t.txt;
-                    break;
-                }
-
-                if (section_path.empty()) {
-                    std::cerr << "[ERROR]: relative nesting of '" << t.txt << "' can't be performed, missing parent section\n";
-                    return false;
-                }
-                section_path += t.txt;
+            case ini::detail::Parse_Error::INVALID_KEY:
+                error = ini_error(ini::Error_Code::INVALID_KEY, "invalid key identifier '" + t.txt +
+                                  "', use only alphanumeric characters", t.line, t.column);
+                break;
+            case ini::detail::Parse_Error::INSERTION_FAILED:
+                error = ini_error(ini::Error_Code::INSERTION_FAILED, "something happened during '" + t.txt +
+                                  "' -> '" + tokens[parser.get_subject() + 2].txt + "' insertion", t.line, t.column);
+                break;
+            case ini::detail::Parse_Error::MISSING_PARENT_SECTION:
+                error = ini_error(ini::Error_Code::MISSING_PARENT_SECTION, "relative nesting of '" + t.txt +
+                                  "' can't be performed, missing parent section", t.line, t.column);
                 break;
             default:
-                std::cerr << "[ERROR]: something wrong happened\n";
-                return false;
+                error = ini_error(ini::Error_Code::INVALID_TOKEN, "unexpected token '" + t.txt + "'", t.line, t.column);
+                break;
         }
-        return true;
     }
 
-    bool match(ini_Token_Type type) {
-        if (end()) return false;
-        return tokens[current].type == type;
-    }
-
-    ini_Token &advance() {
-        return tokens[current++];
-    }
-
-    ini_Token &peek() {
-        return tokens[current];
-    }
-
-    bool end() {
-        return current >= tokens.size();
-    }
-
-    std::vector<ini_Token> tokens;
-    int current = 0;
-    std::string section_path;
+    std::vector<ini_Token> &tokens;
+    ini::ReadStats *stats;
+    ini::Error error;
 };
 
 std::vector<std::string> string_split(std::string &str, const std::string &delim) {
@@ -220,7 +357,7 @@ std::vector<std::string> string_split(std::string &str, const std::string &delim
 void ini_section_to_string(std::string &str, const char kvs, ini::Section &sec, const std::string &sec_name = "") {
     if (!sec_name.empty()) str += "[" + sec_name + "]\n";
 
-    for (auto &kv : sec.get_props()) {
+    for (auto &kv : Access::props(sec)) {
         str += kv.first;
         str.push_back(kvs);
         if (kv.second.contains(' ')) str += " \"" + kv.second + "\"";
@@ -230,13 +367,15 @@ void ini_section_to_string(std::string &str, const char kvs, ini::Section &sec,
 
     str += "\n";
     if (!sec_name.empty()) {
-        for (auto &kv : sec.get_subsecs()) {
+        for (auto &kv : Access::subsecs(sec)) {
             ini_section_to_string(str, kvs, kv.second, sec_name + "." + kv.first);
         }
     }
 }
 
-bool ini::add_property(ini::Object &ini, std::string &key, std::string &value, std::string &section_path) {
+template<bool WithStats>
+bool ini_add_property(ini::Object &ini, std::string &key, std::string &value, std::string &section_path,
+                      ini_Insertion &created) {
     if (key.empty() || value.empty()) return false;
 
     // key symbol cannot contain "=" and ";" inside the Windows implementation.
@@ -252,21 +391,52 @@ bool ini::add_property(ini::Object &ini, std::string &key, std::string &value, s
         for (auto &i : path) {
             try {
                 i = to_lower(i);
-                sec = &sec->get_subsecs().at(i);
+                sec = &Access::subsecs(*sec).at(i);
             } catch (std::out_of_range &e) {
                 // keep adding missing sections.
+                auto &subsecs = Access::subsecs(*sec);
+                size_t buckets = subsecs.bucket_count();
                 if (!ini::add_section(*sec, i)) {
                     std::cerr << "[ERROR]: could not create new section '" << i << "'\n";
                     return false;
                 }
 
-                sec = &sec->get_subsecs().at(i);
+                sec = &subsecs.at(i);
+                created.sections++;
+                if constexpr (WithStats) {
+                    created.count_node(subsecs, buckets);
+                    created.count_string(i);
+                    created.count_string(sec->get_name());
+                    created.count_string(sec->get_path());
+                }
             }
         }
     }
 
     // case-insensitive.
-    return ini::add_property(*sec, key, value);
+    auto &props = Access::props(*sec);
+    size_t size = props.size();
+    size_t buckets = props.bucket_count();
+    if (!ini_section_add_property(*sec, key, value)) return false;
+
+    // an already existing key keeps its value, and its index entry.
+    if (props.size() == size) return true;
+    created.properties++;
+    if constexpr (WithStats) {
+        created.count_node(props, buckets);
+        auto &inserted = *props.find(to_lower(key));
+        created.count_string(inserted.first);
+        created.count_string(inserted.second);
+    }
+
+    // a stale index is rebuilt by the next query anyway.
+    if (ini_index_fresh(ini)) Access::index(ini).keys[key].push_back(sec == &ini.get_global() ? nullptr : sec);
+    return true;
+}
+
+bool ini::add_property(ini::Object &ini, std::string &key, std::string &value, std::string &section_path) {
+    ini_Insertion created;
+    return ini_add_property<false>(ini, key, value, section_path, created);
 }
 
 bool ini::add_property(ini::Object &ini, std::string &key, std::string &value, std::string &&section_path) {
@@ -297,7 +467,7 @@ bool ini::add_property(ini::Object &ini, std::string &&key, std::string &&value,
     return ini::add_property(ini, key, value, section_path);
 }
 
-bool ini::add_property(ini::Section &sec, std::string &key, std::string &value) {
+bool ini_section_add_property(ini::Section &sec, std::string &key, std::string &value) {
     if (key.empty() || value.empty()) return false;
 
     if (key.contains('=') || key.contains(';')) {
@@ -306,7 +476,7 @@ bool ini::add_property(ini::Section &sec, std::string &key, std::string &value)
     }
 
     try {
-        sec.get_props().insert(std::make_pair(to_lower(key), value));
+        Access::props(sec).insert(std::make_pair(to_lower(key), value));
     } catch (std::bad_alloc &e) {
         std::cerr << "[ERROR]: " << e.what() << std::endl;
         return false;
@@ -314,6 +484,15 @@ bool ini::add_property(ini::Section &sec, std::string &key, std::string &value)
     return true;
 }
 
+bool ini::add_property(ini::Section &sec, std::string &key, std::string &value) {
+    size_t size = Access::props(sec).size();
+    if (!ini_section_add_property(sec, key, value)) return false;
+
+    // the section doesn't know its path inside the index, the next query rebuilds it.
+    if (Access::props(sec).size() != size) Access::modified(sec);
+    return true;
+}
+
 bool ini::add_property(ini::Section &sec, std::string &key, std::string &&value) {
     return ini::add_property(sec, key, value);
 }
@@ -334,14 +513,14 @@ std::string &ini::get_property(ini::Object &ini, std::string &key, std::string &
         for (auto &i : path) {
             try {
                 i = to_lower(i);
-                sec = &sec->get_subsecs().at(i);
+                sec = &Access::subsecs(*sec).at(i);
             } catch (std::out_of_range &e) {
                 throw std::out_of_range("ini::get_property: missing section '" + i + "'");
             }
         }
     }
 
-    return sec->get_props().at(key);
+    return Access::props(*sec).at(key);
 }
 
 std::string &ini::get_property(ini::Object &ini, std::string &key, std::string &&section_path) {
@@ -368,7 +547,7 @@ bool ini::add_section(ini::Object &ini, std::string &new_section_name, std::stri
 
         for (auto &i : path) {
             try {
-                sec = &sec->get_subsecs().at(i);
+                sec = &Access::subsecs(*sec).at(i);
             } catch (std::out_of_range &e) {
                 // keep adding missing sections.
                 i = to_lower(i);
@@ -383,7 +562,7 @@ bool ini::add_section(ini::Object &ini, std::string &new_section_name, std::stri
                     std::cerr << "[ERROR]: could not create missing '" << i << "' section\n";
                     return false;
                 }
-                sec = &sec->get_subsecs().at(i);
+                sec = &Access::subsecs(*sec).at(i);
             }
         }
     }
@@ -409,7 +588,12 @@ bool ini::add_section(ini::Section &sec, std::string &new_section_name) {
 
     new_section_name = to_lower(new_section_name);
     try {
-        sec.get_subsecs().insert(std::make_pair(new_section_name, Section(new_section_name)));
+        auto [it, inserted] = Access::subsecs(sec).try_emplace(new_section_name, new_section_name);
+        if (inserted) {
+            Access::path(it->second) = sec.get_path().empty() ? new_section_name
+                                                              : sec.get_path() + "." + new_section_name;
+            Access::changes(it->second) = Access::changes(sec);
+        }
     } catch (std::bad_alloc &e) {
         std::cerr << "[ERROR]: " << e.what() << std::endl;
         return false;
@@ -429,7 +613,7 @@ ini::Section &ini::get_section(ini::Object &ini, std::string &section_name, std:
         for (auto &i : path) {
             try {
                 i = to_lower(i);
-                sec = &sec->get_subsecs().at(i);
+                sec = &Access::subsecs(*sec).at(i);
             } catch (std::out_of_range &e) {
                 throw std::out_of_range("ini::get_section: missing section '" + i + "'");
             }
@@ -437,7 +621,7 @@ ini::Section &ini::get_section(ini::Object &ini, std::string &section_name, std:
     }
 
     section_name = to_lower(section_name);
-    return sec->get_subsecs().at(section_name);
+    return Access::subsecs(*sec).at(section_name);
 }
 
 ini::Section &ini::get_section(ini::Object &ini, std::string &section_name, std::string &&section_path) {
@@ -452,55 +636,176 @@ ini::Section &ini::get_section(ini::Object &ini, std::string &&section_name, std
     return ini::get_section(ini, section_name, section_path);
 }
 
-ini::Object ini::read(std::string &path) {
-    ini::Object ini(path);
-
-    if (!path.ends_with(".ini")) {
-        std::cerr << "[ERROR]: file \"" + ini.get_file_path() + "\" has an incompatible extension type\n";
-        return ini;
+// nullptr if a section is missing.
+ini::Section *ini_find_section(ini::Object &ini, std::string &section_path) {
+    ini::Section *sec = &ini.get_global();
+    if (section_path.empty()) return sec;
+
+    auto path = string_split(section_path, ".");
+    for (auto &i : path) {
+        auto &subsecs = Access::subsecs(*sec);
+        auto it = subsecs.find(to_lower(i));
+        if (it == subsecs.end()) return nullptr;
+        sec = &it->second;
     }
+    return sec;
+}
 
-    if (!ini::read(ini)) {
-        std::cerr << "[ERROR]: failed during file reading\n";
+bool ini::remove_property(ini::Object &ini, std::string &key, std::string &section_path) {
+    ini::Section *sec = ini_find_section(ini, section_path);
+    if (!sec) return false;
+
+    key = to_lower(key);
+    if (Access::props(*sec).erase(key) == 0) return false;
+
+    if (ini_index_fresh(ini)) {
+        auto &keys = Access::index(ini).keys;
+        auto it = keys.find(key);
+        if (it != keys.end()) {
+            std::erase(it->second, sec == &ini.get_global() ? nullptr : sec);
+            if (it->second.empty()) keys.erase(it);
+        }
     }
+    return true;
+}
 
-    return ini;
+bool ini::remove_property(ini::Object &ini, std::string &key, std::string &&section_path) {
+    return ini::remove_property(ini, key, section_path);
 }
 
-ini::Object ini::read(std::string &&path) {
-    return ini::read(path);
+bool ini::remove_property(ini::Object &ini, std::string &&key, std::string &section_path) {
+    return ini::remove_property(ini, key, section_path);
 }
 
-bool ini::read(ini::Object &ini) {
-    std::string text;
+bool ini::remove_property(ini::Object &ini, std::string &&key, std::string &&section_path) {
+    return ini::remove_property(ini, key, section_path);
+}
+
+bool ini::remove_section(ini::Object &ini, std::string &section_name, std::string &section_path) {
+    ini::Section *sec = ini_find_section(ini, section_path);
+    if (!sec) return false;
+
+    section_name = to_lower(section_name);
+    if (Access::subsecs(*sec).erase(section_name) == 0) return false;
+
+    // the index doesn't know which of its sections were below the removed one, the next query rebuilds it.
+    Access::index(ini) = ini::Index();
+    return true;
+}
+
+bool ini::remove_section(ini::Object &ini, std::string &section_name, std::string &&section_path) {
+    return ini::remove_section(ini, section_name, section_path);
+}
 
+bool ini::remove_section(ini::Object &ini, std::string &&section_name, std::string &section_path) {
+    return ini::remove_section(ini, section_name, section_path);
+}
+
+bool ini::remove_section(ini::Object &ini, std::string &&section_name, std::string &&section_path) {
+    return ini::remove_section(ini, section_name, section_path);
+}
+
+template<bool WithStats>
+bool ini_read(ini::Object &ini, ini::Error &error, ini::ReadStats *stats = nullptr) {
     if (!ini.get_file_path().ends_with(".ini")) {
-        std::cerr << "[ERROR]: file \"" + ini.get_file_path() + "\" has an incompatible extension type\n";
+        error = ini_error(ini::Error_Code::BAD_EXTENSION,
+                          "file \"" + ini.get_file_path() + "\" has an incompatible extension type");
         return false;
     }
 
+    ini_Clock::time_point begin;
+    if constexpr (WithStats) begin = ini_Clock::now();
+
     std::ifstream file;
     file.open(ini.get_file_path());
 
     if (!file.is_open()) {
-        std::cerr << "[ERROR]: failed to open '" << ini.get_file_path() << "'\n";
+        error = ini_error(ini::Error_Code::OPEN_FAILED, "failed to open '" + ini.get_file_path() + "'");
         return false;
     }
 
+    std::string text;
     std::string line;
     while (file.good()) {
+        size_t capacity = text.capacity();
         std::getline(file, line);
         text += line + "\n";
+
+        if constexpr (WithStats) {
+            if (text.capacity() != capacity) {
+                stats->estimated_allocations++;
+                stats->estimated_allocated_bytes += text.capacity() + 1;
+            }
+        }
     }
     file.close();
 
+    if constexpr (WithStats) {
+        stats->io_time = ini_Clock::now() - begin;
+        stats->bytes_read = text.size();
+        begin = ini_Clock::now();
+    }
+
     // lexing.
     ini_Lexer lexer(text, ini.get_file_path());
-    auto tokens = lexer.scan_tokens();
+    auto tokens = lexer.scan_tokens<WithStats>(stats);
+
+    if constexpr (WithStats) {
+        stats->lex_time = ini_Clock::now() - begin;
+        begin = ini_Clock::now();
+    }
+
+    if (lexer.get_error().code != ini::Error_Code::NONE) {
+        error = lexer.get_error();
+        return false;
+    }
 
     // parsing.
-    ini_Parser parser(tokens);
-    return parser.parse_tokens(ini);
+    ini_Parser<WithStats> parser(tokens, stats);
+    bool result = parser.parse_tokens(ini);
+    if (!result) error = parser.get_error();
+
+    if constexpr (WithStats) stats->parse_time = ini_Clock::now() - begin;
+
+    return result;
+}
+
+ini::Object ini::read(std::string &path) {
+    ini::Object ini(path);
+
+    if (!ini::read(ini)) {
+        std::cerr << "[ERROR]: failed during file reading\n";
+    }
+
+    return ini;
+}
+
+ini::Object ini::read(std::string &&path) {
+    return ini::read(path);
+}
+
+ini::Object ini::read(std::string &path, ini::ReadStats &stats) {
+    ini::Object ini(path);
+    ini::read(ini, stats);
+    return ini;
+}
+
+ini::Object ini::read(std::string &&path, ini::ReadStats &stats) {
+    return ini::read(path, stats);
+}
+
+bool ini::read(ini::Object &ini) {
+    ini::Error error;
+    if (!ini_read<false>(ini, error)) {
+        std::cerr << "[ERROR]: " << error.message << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool ini::read(ini::Object &ini, ini::ReadStats &stats) {
+    stats = ini::ReadStats();
+    return ini_read<true>(ini, stats.error, &stats);
 }
 
 bool ini::write(ini::Object &ini, const char key_val_separator) {
@@ -516,7 +821,7 @@ bool ini::write(ini::Object &ini, const char key_val_separator) {
 
     std::string content;
     ini_section_to_string(content, key_val_separator, ini.get_global());
-    for (auto &kv: ini.get_global().get_subsecs()) {
+    for (auto &kv: Access::subsecs(ini.get_global())) {
         ini_section_to_string(content, key_val_separator, kv.second, kv.first);
     }
 
@@ -525,4 +830,246 @@ bool ini::write(ini::Object &ini, const char key_val_separator) {
     output_file.close();
 
     return true;
-}
\ No newline at end of file
+}
+
+template<typename Map>
+void ini_shrink_buckets(Map &map) {
+    if (map.empty()) {
+        Map().swap(map);
+        return;
+    }
+
+    size_t buckets = map.bucket_count();
+    map.rehash(0);
+    if (map.bucket_count() > buckets) map.rehash(buckets);
+}
+
+void ini_section_memory(ini::MemoryUsage &usage, std::unordered_set<std::string_view> &values,
+                        const ini::Section &sec) {
+    ini::SectionMemory mem;
+    mem.path = sec.get_path();
+    mem.keys += ini_string_heap(sec.get_name());
+    mem.keys += ini_string_heap(sec.get_path());
+
+    for (auto &kv : sec.get_props()) {
+        mem.keys += ini_string_heap(kv.first);
+
+        size_t heap = ini_string_heap(kv.second);
+        mem.values += heap;
+        if (!values.insert(kv.second).second) usage.duplicate_values += heap;
+    }
+    mem.map_overhead += sec.get_props().size() * ini_node_size<std::unordered_map<std::string, std::string>>();
+    mem.buckets += ini_buckets_size(sec.get_props());
+
+    for (auto &kv : sec.get_subsecs()) {
+        mem.keys += ini_string_heap(kv.first);
+    }
+    mem.map_overhead += sec.get_subsecs().size() * ini_node_size<std::unordered_map<std::string, ini::Section>>();
+    mem.buckets += ini_buckets_size(sec.get_subsecs());
+
+    usage.sections.push_back(std::move(mem));
+
+    for (auto &kv : sec.get_subsecs()) {
+        ini_section_memory(usage, values, kv.second);
+    }
+}
+
+void ini_section_compact(ini::Section &sec) {
+    for (auto &kv : Access::props(sec)) {
+        // keys are const inside the map and are never built with excess capacity.
+        kv.second.shrink_to_fit();
+    }
+    ini_shrink_buckets(Access::props(sec));
+
+    for (auto &kv : Access::subsecs(sec)) {
+        ini_section_compact(kv.second);
+    }
+    ini_shrink_buckets(Access::subsecs(sec));
+}
+
+ini::MemoryUsage ini::memory_usage(const ini::Object &ini) {
+    ini::MemoryUsage usage;
+    usage.object = ini_string_heap(ini.get_file_path());
+    // the change counter.
+    if (ini.get_version() != ini::Index::STALE) usage.object += sizeof(uint64_t);
+
+    std::unordered_set<std::string_view> values;
+    ini_section_memory(usage, values, ini.get_global());
+
+    const ini::Index &index = ini.get_index();
+    usage.index += index.keys.size() * ini_node_size<decltype(index.keys)>();
+    usage.index += ini_buckets_size(index.keys);
+    for (auto &kv : index.keys) {
+        usage.index += ini_string_heap(kv.first);
+        usage.index += kv.second.capacity() * sizeof(const ini::Section *);
+    }
+    return usage;
+}
+
+void ini::compact(ini::Object &ini) {
+    ini_section_compact(ini.get_global());
+
+    auto &index = Access::index(ini);
+    for (auto &kv : index.keys) {
+        kv.second.shrink_to_fit();
+    }
+    ini_shrink_buckets(index.keys);
+}
+
+void ini_section_reindex(ini::Index &index, const ini::Section &sec, const ini::Section *entry) {
+    for (auto &kv : sec.get_props()) {
+        index.keys[kv.first].push_back(entry);
+    }
+
+    for (auto &kv : sec.get_subsecs()) {
+        ini_section_reindex(index, kv.second, &kv.second);
+    }
+}
+
+void ini::reindex(ini::Object &ini) {
+    auto &index = Access::index(ini);
+    index = ini::Index();
+    index.version = ini.get_version();
+    ini_section_reindex(index, ini.get_global(), nullptr);
+}
+
+// splits the first segment of a dotted path from the rest.
+std::pair<std::string_view, std::string_view> ini_first_segment(std::string_view path) {
+    size_t dot = path.find('.');
+    if (dot == std::string_view::npos) return {path, ""};
+    return {path.substr(0, dot), path.substr(dot + 1)};
+}
+
+bool ini_is_wildcard(std::string_view segment) {
+    return segment == "*" || segment == "**";
+}
+
+// '*' matches one segment, '**' any number of them, pattern[p, end) against the whole path.
+bool ini_glob_match(const std::vector<std::string_view> &pattern, size_t p, size_t end, std::string_view path) {
+    if (p == end) return path.empty();
+
+    if (pattern[p] == "**") {
+        if (ini_glob_match(pattern, p + 1, end, path)) return true;
+        if (path.empty()) return false;
+        return ini_glob_match(pattern, p, end, ini_first_segment(path).second);
+    }
+
+    if (path.empty()) return false;
+
+    auto [segment, rest] = ini_first_segment(path);
+    if (pattern[p] != "*" && pattern[p] != segment) return false;
+    return ini_glob_match(pattern, p + 1, end, rest);
+}
+
+// walks the literal segments pattern[0, end) from the global section, nullptr if a section is missing.
+const ini::Section *ini_resolve(const ini::Section &global, const std::vector<std::string_view> &pattern,
+                                size_t end) {
+    const ini::Section *sec = &global;
+    std::string name;
+    for (size_t p = 0; p < end; p++) {
+        name.assign(pattern[p]);
+
+        auto it = sec->get_subsecs().find(name);
+        if (it == sec->get_subsecs().end()) return nullptr;
+        sec = &it->second;
+    }
+    return sec;
+}
+
+// every property of sec and of the sections below it whose path matches pattern[0, end), down to max_depth.
+void ini_collect_all(std::vector<ini::Match> &matches, const ini::Section &sec,
+                     const std::vector<std::string_view> &pattern, size_t end, size_t depth, size_t max_depth) {
+    if (ini_glob_match(pattern, 0, end, sec.get_path())) {
+        for (auto &kv : sec.get_props()) matches.push_back(ini::Match{sec.get_path(), kv.first, kv.second});
+    }
+
+    if (depth == max_depth) return;
+    for (auto &kv : sec.get_subsecs()) {
+        ini_collect_all(matches, kv.second, pattern, end, depth + 1, max_depth);
+    }
+}
+
+std::vector<ini::Match> ini::query(ini::Object &ini, std::string_view pattern) {
+    std::string lowered(pattern);
+    to_lower(lowered);
+
+    std::vector<std::string_view> segments;
+    std::string_view rest = lowered;
+    while (!rest.empty()) {
+        auto [segment, next] = ini_first_segment(rest);
+        if (!segment.empty()) segments.push_back(segment);
+        rest = next;
+    }
+
+    std::vector<ini::Match> matches;
+    if (segments.empty()) return matches;
+
+    // sections before the first wildcard are looked up directly.
+    size_t literal = 0;
+    while (literal < segments.size() && !ini_is_wildcard(segments[literal])) literal++;
+
+    if (ini_is_wildcard(segments.back())) {
+        // no key to narrow the search: a trailing '*' is any key, a trailing '**' any key at any depth.
+        size_t end = segments.back() == "**" ? segments.size() : segments.size() - 1;
+        const ini::Section *root = ini_resolve(ini.get_global(), segments, literal);
+        if (!root) return matches;
+
+        auto first = segments.begin() + static_cast<std::ptrdiff_t>(literal);
+        auto last = segments.begin() + static_cast<std::ptrdiff_t>(end);
+        bool deep = std::find(first, last, "**") != last;
+        ini_collect_all(matches, *root, segments, end, literal, deep ? SIZE_MAX : end);
+        return matches;
+    }
+
+    auto collect = [&](const ini::Section &sec, const std::string &key) {
+        auto prop = sec.get_props().find(key);
+        if (prop != sec.get_props().end()) matches.push_back(ini::Match{sec.get_path(), prop->first, prop->second});
+    };
+
+    // keys may contain dots: every literal tail of the pattern is a candidate key.
+    std::string key;
+    for (size_t k = segments.size(); k-- > 0;) {
+        if (ini_is_wildcard(segments[k])) break;
+        key = k + 1 == segments.size() ? std::string(segments[k]) : std::string(segments[k]) + "." + key;
+
+        if (k <= literal) {
+            const ini::Section *sec = ini_resolve(ini.get_global(), segments, k);
+            if (sec) collect(*sec, key);
+            continue;
+        }
+
+        // wildcards inside the path: only the sections defining the key are visited.
+        if (!ini_index_fresh(ini)) ini::reindex(ini);
+        const auto &keys = ini.get_index().keys;
+        auto it = keys.find(key);
+        if (it == keys.end()) continue;
+
+        for (auto *entry : it->second) {
+            const ini::Section *sec = entry ? entry : &ini.get_global();
+            if (ini_glob_match(segments, 0, k, sec->get_path())) collect(*sec, key);
+        }
+    }
+    return matches;
+}
+
+bool ini::convert(const std::string &txt, std::string &out) {
+    out = txt;
+    return true;
+}
+
+bool ini::convert(const std::string &txt, bool &out) {
+    std::string value = txt;
+    to_lower(value);
+
+    if (value == "true" || value == "yes" || value == "on" || value == "1") {
+        out = true;
+        return true;
+    }
+
+    if (value == "false" || value == "no" || value == "off" || value == "0") {
+        out = false;
+        return true;
+    }
+
+    return false;
+}
@@ -38,17 +38,42 @@
  * quoted values are used to explicit define spaces inside values.
  */
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include <unordered_map>
 
 namespace ini {
+    namespace detail {
+        struct Access;
+    }
+
     class Section {
     public:
         explicit Section(std::string sec_name = "global") : sec_name(std::move(sec_name)) {}
 
+        // copies don't belong to any object, changes made to them are not tracked.
+        Section(const Section &other) : sec_name(other.sec_name), path(other.path), props(other.props),
+                                        subsecs(other.subsecs) {}
+
+        // the moved subsections leave their object as well.
+        Section(Section &&other);
+
+        // the section keeps its path and its object, the assigned subsections join them.
+        Section &operator=(const Section &other);
+        Section &operator=(Section &&other);
+
         [[nodiscard]] bool props_empty() const {
             return props.empty();
         }
@@ -65,23 +90,50 @@ namespace ini {
             this->sec_name = name;
         }
 
-        [[nodiscard]] std::unordered_map<std::string, std::string> &get_props() {
+        // read-only, changes go through the ini functions to keep the query index in sync.
+        [[nodiscard]] const std::unordered_map<std::string, std::string> &get_props() const {
             return this->props;
         }
 
-        [[nodiscard]] std::unordered_map<std::string, Section> &get_subsecs() {
+        [[nodiscard]] const std::unordered_map<std::string, Section> &get_subsecs() const {
             return this->subsecs;
         }
 
+        // dotted lowercase path from the global section, empty for the global section itself.
+        [[nodiscard]] const std::string &get_path() const {
+            return this->path;
+        }
+
     private:
+        friend struct detail::Access;
+
         std::string sec_name;
+        std::string path;
         std::unordered_map<std::string, std::string> props;
         std::unordered_map<std::string, Section> subsecs;
+        // change counter of the owning object, nullptr outside of an object.
+        uint64_t *changes = nullptr;
+    };
+
+    // key index used by ini::query.
+    struct Index {
+        static constexpr uint64_t STALE = UINT64_MAX;
+
+        // key -> sections defining it, nullptr stands for the global section.
+        std::unordered_map<std::string, std::vector<const Section *>> keys;
+        // Object::get_version() the index is in sync with, ini::query rebuilds it on mismatch.
+        uint64_t version = STALE;
     };
 
     class Object {
     public:
-        explicit Object(std::string file_path) : file_path(std::move(file_path)), global(Section()) {}
+        explicit Object(std::string file_path);
+
+        // copies leave the index to be rebuilt by the first query, moves keep it.
+        Object(const Object &other);
+        Object &operator=(const Object &other);
+        Object(Object &&other) noexcept;
+        Object &operator=(Object &&other) noexcept;
 
         [[nodiscard]] const std::string &get_file_path() const {
             return file_path;
@@ -95,11 +147,64 @@ namespace ini {
             return global;
         }
 
+        [[nodiscard]] const Section &get_global() const {
+            return global;
+        }
+
+        [[nodiscard]] const Index &get_index() const {
+            return index;
+        }
+
+        // counts the changes the index can't follow: add_property on a Section, assigning or moving sections.
+        // Index::STALE once the object has been moved from.
+        [[nodiscard]] uint64_t get_version() const {
+            return changes ? *changes : Index::STALE;
+        }
+
     private:
+        friend struct detail::Access;
+
         std::string file_path;
         Section global;
+        Index index;
+        // on the heap, so that sections keep pointing to it when the object is moved.
+        std::unique_ptr<uint64_t> changes;
     };
 
+    namespace detail {
+        // used by the library to change sections and objects.
+        struct Access {
+            static std::unordered_map<std::string, std::string> &props(Section &sec) {
+                return sec.props;
+            }
+
+            static std::unordered_map<std::string, Section> &subsecs(Section &sec) {
+                return sec.subsecs;
+            }
+
+            static std::string &path(Section &sec) {
+                return sec.path;
+            }
+
+            static uint64_t *&changes(Section &sec) {
+                return sec.changes;
+            }
+
+            static std::unique_ptr<uint64_t> &changes(Object &ini) {
+                return ini.changes;
+            }
+
+            static Index &index(Object &ini) {
+                return ini.index;
+            }
+
+            // for changes the index of the owning object can't follow.
+            static void modified(Section &sec) {
+                if (sec.changes) (*sec.changes)++;
+            }
+        };
+    }
+
     bool add_property(Object &ini, std::string &key, std::string &value, std::string &section_path);
     bool add_property(Object &ini, std::string &key, std::string &value, std::string &&section_path = "");
     bool add_property(Object &ini, std::string &key, std::string &&value, std::string &section_path);
@@ -132,12 +237,867 @@ namespace ini {
     Section &get_section(Object &ini, std::string &&section_name, std::string &section_path);
     Section &get_section(Object &ini, std::string &&section_name, std::string &&section_path = "");
 
+    // false if the property or the section is missing.
+    bool remove_property(Object &ini, std::string &key, std::string &section_path);
+    bool remove_property(Object &ini, std::string &key, std::string &&section_path = "");
+    bool remove_property(Object &ini, std::string &&key, std::string &section_path);
+    bool remove_property(Object &ini, std::string &&key, std::string &&section_path = "");
+
+    bool remove_section(Object &ini, std::string &section_name, std::string &section_path);
+    bool remove_section(Object &ini, std::string &section_name, std::string &&section_path = "");
+    bool remove_section(Object &ini, std::string &&section_name, std::string &section_path);
+    bool remove_section(Object &ini, std::string &&section_name, std::string &&section_path = "");
+
+    enum class Error_Code {
+        NONE,
+        BAD_EXTENSION,
+        OPEN_FAILED,
+        UNCLOSED_SECTION,
+        UNCLOSED_STRING,
+        UNEXPECTED_CHARACTER,
+        INVALID_TOKEN,
+        INVALID_KEY,
+        MISSING_PARENT_SECTION,
+        INSERTION_FAILED,
+    };
+
+    struct Error {
+        Error_Code code = Error_Code::NONE;
+        // line and column are 0 when the error is not bound to a position.
+        int line = 0;
+        int column = 0;
+        std::string message;
+    };
+
+    // filled by the read overloads that take it, the others don't pay for it.
+    struct ReadStats {
+        std::chrono::nanoseconds io_time{0};
+        std::chrono::nanoseconds lex_time{0};
+        // includes insert_time.
+        std::chrono::nanoseconds parse_time{0};
+        std::chrono::nanoseconds insert_time{0};
+
+        size_t bytes_read = 0;
+        size_t tokens = 0;
+        size_t sections = 0;
+        size_t properties = 0;
+
+        // partial estimate, not a count of every heap allocation. it covers:
+        // growth of the text buffer, growth of the token buffer, token texts out of the small string buffer,
+        // one node per new section and property, the stored keys, values and section names
+        // and the growth of bucket arrays.
+        // it misses temporaries (section path splitting, lowercased copies) and the key index.
+        size_t estimated_allocations = 0;
+        size_t estimated_allocated_bytes = 0;
+
+        // bytes held by the tokens when lexing ends.
+        size_t token_buffer_peak = 0;
+
+        // nothing is printed to stderr, errors are reported here.
+        Error error;
+    };
+
     Object read(std::string &path);
     Object read(std::string &&path);
+    Object read(std::string &path, ReadStats &stats);
+    Object read(std::string &&path, ReadStats &stats);
 
     bool read(Object &ini);
+    bool read(Object &ini, ReadStats &stats);
 
     bool write(Object &ini, char key_val_separator);
+
+    // heap bytes owned by a section, children excluded.
+    struct SectionMemory {
+        // dotted path, empty for the global section.
+        std::string path;
+        // property keys, subsection keys and the section name.
+        size_t keys = 0;
+        size_t values = 0;
+        // map nodes of properties and subsections.
+        size_t map_overhead = 0;
+        size_t buckets = 0;
+
+        [[nodiscard]] size_t total() const {
+            return keys + values + map_overhead + buckets;
+        }
+    };
+
+    struct MemoryUsage {
+        // file path.
+        size_t object = 0;
+        std::vector<SectionMemory> sections;
+        // key index used by ini::query.
+        size_t index = 0;
+        // heap bytes of values equal to an already seen one, not included inside total().
+        size_t duplicate_values = 0;
+
+        [[nodiscard]] size_t total() const {
+            size_t sum = object + index;
+            for (auto &s : sections) sum += s.total();
+            return sum;
+        }
+    };
+
+    MemoryUsage memory_usage(const Object &ini);
+
+    // rehashes every map down to its size and releases the excess capacity of values.
+    void compact(Object &ini);
+
+    struct Match {
+        std::string_view path;
+        std::string_view key;
+        std::string_view value;
+    };
+
+    /*
+     * "servers.*.port" -> every 'port' inside a direct subsection of 'servers'.
+     * "servers.**.port" -> every 'port' at any depth below 'servers', 'servers' included.
+     * "servers.eu1.*" -> every property of 'servers.eu1'.
+     * "servers.**" -> every property at any depth below 'servers', 'servers' included. "**" matches everything.
+     *
+     * wildcards match whole segments only. keys may contain dots, so every literal tail
+     * of the pattern is tried as a key: "s.a.b" finds both 'b' inside 's.a' and 'a.b' inside 's'.
+     * the sections before the first wildcard are looked up directly,
+     * with a literal key only the sections defining it are visited.
+     *
+     * the index is rebuilt first if the object changed in a way it can't follow (see Object::get_version()).
+     * views point into the sections: they are valid until the matched property or section is removed.
+     */
+    std::vector<Match> query(Object &ini, std::string_view pattern);
+
+    // rebuilds the index, ini::query does it when needed.
+    void reindex(Object &ini);
+
+    /*
+     * SCHEMA BINDING:
+     *
+     * INI_BIND(MyCfg, section("db"), field(&MyCfg::port, "port"), field(&MyCfg::host, "host").required())
+     *
+     * every field belongs to the last section declared before it (global if none).
+     * the key table is built at compile time and ini::load fills the struct
+     * with a single traversal of the object, without splitting any path.
+     *
+     * INI_BIND specializes ini::Schema, so it has to be used at global namespace scope,
+     * with a fully qualified type if the struct lives inside a namespace.
+     */
+
+    bool convert(const std::string &txt, std::string &out);
+    bool convert(const std::string &txt, bool &out);
+
+    template<typename T>
+    requires (std::is_integral_v<T> || std::is_floating_point_v<T>)
+    bool convert(const std::string &txt, T &out) {
+        auto res = std::from_chars(txt.data(), txt.data() + txt.size(), out);
+        return res.ec == std::errc() && res.ptr == txt.data() + txt.size();
+    }
+
+    enum class Presence {
+        OPTIONAL,
+        REQUIRED,
+        DEFAULTED,
+    };
+
+    struct no_default {};
+
+    struct section {
+        constexpr explicit section(std::string_view path) : path(path) {}
+
+        std::string_view path;
+    };
+
+    template<typename T, typename M, typename D = no_default>
+    struct field {
+        constexpr field(M T::*member, std::string_view key, Presence presence = Presence::OPTIONAL, D def = {})
+                : member(member), key(key), presence(presence), def(def) {}
+
+        // missing key makes ini::load fail.
+        [[nodiscard]] constexpr field required() const {
+            return field(member, key, Presence::REQUIRED, def);
+        }
+
+        // missing key assigns 'value' to the member.
+        template<typename V>
+        [[nodiscard]] constexpr field<T, M, V> or_default(V value) const {
+            return field<T, M, V>(member, key, Presence::DEFAULTED, value);
+        }
+
+        M T::*member;
+        std::string_view key;
+        Presence presence;
+        D def;
+    };
+
+    namespace detail {
+        constexpr char ascii_lower(char c) {
+            return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+
+        // case-insensitive three-way comparison.
+        constexpr int icompare(std::string_view a, std::string_view b) {
+            size_t n = a.size() < b.size() ? a.size() : b.size();
+            for (size_t i = 0; i < n; i++) {
+                auto x = static_cast<unsigned char>(ascii_lower(a[i]));
+                auto y = static_cast<unsigned char>(ascii_lower(b[i]));
+                if (x != y) return x < y ? -1 : 1;
+            }
+            if (a.size() == b.size()) return 0;
+            return a.size() < b.size() ? -1 : 1;
+        }
+
+        constexpr bool istarts_with(std::string_view str, std::string_view prefix) {
+            return str.size() >= prefix.size() && icompare(str.substr(0, prefix.size()), prefix) == 0;
+        }
+
+        template<typename I>
+        struct is_field : std::false_type {};
+
+        template<typename T, typename M, typename D>
+        struct is_field<field<T, M, D>> : std::true_type {};
+
+        struct Key {
+            std::string_view section;
+            std::string_view key;
+            // index of the field inside the binding items.
+            size_t item;
+        };
+
+        constexpr bool key_less(const Key &a, const Key &b) {
+            int c = icompare(a.section, b.section);
+            if (c != 0) return c < 0;
+            return icompare(a.key, b.key) < 0;
+        }
+    }
+
+    template<typename T, typename... Items>
+    class Binding {
+    public:
+        static constexpr size_t fields_count = (0 + ... + (detail::is_field<Items>::value ? 1 : 0));
+
+        constexpr explicit Binding(Items... items) : items(items...), table(build_table()) {
+            for (size_t i = 1; i < table.size(); i++) {
+                if (!detail::key_less(table[i - 1], table[i])) throw "ini::Binding: duplicate key inside schema";
+            }
+        }
+
+        [[nodiscard]] constexpr const std::array<detail::Key, fields_count> &get_table() const {
+            return table;
+        }
+
+        bool load(const Object &ini, T &out) const {
+            std::array<bool, sizeof...(Items)> seen{};
+            if (!load_section(ini.get_global(), "", out, seen)) return false;
+
+            bool result = true;
+            for (auto &k : table) {
+                if (seen[k.item]) continue;
+                visit(k.item, [&](auto &f) {
+                    if (f.presence == Presence::REQUIRED) {
+                        std::cerr << "[ERROR]: missing required key '" << k.key << "' inside '"
+                                  << (k.section.empty() ? "global" : k.section) << "'\n";
+                        result = false;
+                    } else if constexpr (!std::is_same_v<std::remove_cvref_t<decltype(f.def)>, no_default>) {
+                        if (f.presence == Presence::DEFAULTED) out.*f.member = f.def;
+                    }
+                });
+            }
+            return result;
+        }
+
+    private:
+        constexpr std::array<detail::Key, fields_count> build_table() const {
+            std::array<detail::Key, fields_count> t{};
+            std::string_view current;
+            size_t n = 0;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ([&] {
+                    auto &item = std::get<I>(items);
+                    if constexpr (detail::is_field<std::remove_cvref_t<decltype(item)>>::value) {
+                        t[n++] = detail::Key{current, item.key, I};
+                    } else {
+                        current = item.path;
+                    }
+                }(), ...);
+            }(std::index_sequence_for<Items...>{});
+            std::sort(t.begin(), t.end(), detail::key_less);
+            return t;
+        }
+
+        template<typename F>
+        void visit(size_t item, F &&fn) const {
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ([&] {
+                    if constexpr (detail::is_field<std::remove_cvref_t<decltype(std::get<I>(items))>>::value) {
+                        if (I == item) fn(std::get<I>(items));
+                    }
+                }(), ...);
+            }(std::index_sequence_for<Items...>{});
+        }
+
+        bool load_section(const Section &sec, const std::string &path, T &out, std::array<bool, sizeof...(Items)> &seen) const {
+            auto lo = std::lower_bound(table.begin(), table.end(), path, [](const detail::Key &k, const std::string &p) {
+                return detail::icompare(k.section, p) < 0;
+            });
+            auto hi = lo;
+            while (hi != table.end() && detail::icompare(hi->section, path) == 0) hi++;
+
+            if (lo != hi) {
+                for (auto &kv : sec.get_props()) {
+                    auto k = std::lower_bound(lo, hi, kv.first, [](const detail::Key &k, const std::string &key) {
+                        return detail::icompare(k.key, key) < 0;
+                    });
+                    if (k == hi || detail::icompare(k->key, kv.first) != 0) continue;
+
+                    bool result = true;
+                    visit(k->item, [&](auto &f) {
+                        if (!convert(kv.second, out.*f.member)) {
+                            std::cerr << "[ERROR]: invalid value '" << kv.second << "' for key '" << kv.first << "'\n";
+                            result = false;
+                        }
+                    });
+                    if (!result) return false;
+                    seen[k->item] = true;
+                }
+            }
+
+            for (auto &kv : sec.get_subsecs()) {
+                std::string sub = path.empty() ? kv.first : path + "." + kv.first;
+
+                // skip the branch if no section of the schema lives under it.
+                if (!reaches(sub)) continue;
+                if (!load_section(kv.second, sub, out, seen)) return false;
+            }
+            return true;
+        }
+
+        [[nodiscard]] bool reaches(const std::string &path) const {
+            auto first_not_less = [&](const std::string &p) {
+                return std::lower_bound(table.begin(), table.end(), p, [](const detail::Key &k, const std::string &s) {
+                    return detail::icompare(k.section, s) < 0;
+                });
+            };
+
+            auto it = first_not_less(path);
+            if (it != table.end() && detail::icompare(it->section, path) == 0) return true;
+
+            std::string prefix = path + ".";
+            it = first_not_less(prefix);
+            return it != table.end() && detail::istarts_with(it->section, prefix);
+        }
+
+        std::tuple<Items...> items;
+        std::array<detail::Key, fields_count> table;
+    };
+
+    template<typename T, typename... Items>
+    constexpr Binding<T, Items...> bind(Items... items) {
+        return Binding<T, Items...>(items...);
+    }
+
+    // specialized by INI_BIND.
+    template<typename T>
+    struct Schema;
+
+    template<typename T>
+    bool load(const Object &ini, T &out) {
+        return Schema<T>::binding.load(ini, out);
+    }
+
+    /*
+     * GRAMMAR:
+     *
+     * scanner and parser are shared by the runtime reader (ini::read)
+     * and by the compile-time front end (ini::parse).
+     */
+
+    namespace detail {
+        typedef enum ini_Token_Type {
+            E_O_F = 0,
+            IDENTIFIER = 1,
+            SEPARATOR = 2,
+            SECTION = 3,
+        } ini_Token_Type;
+
+        enum class Scan_Error {
+            NONE,
+            UNCLOSED_SECTION,
+            UNCLOSED_STRING,
+            UNEXPECTED_CHARACTER,
+        };
+
+        struct Lexeme {
+            ini_Token_Type type = E_O_F;
+            std::string_view txt;
+            int line = 1;
+            int column = 1;
+        };
+
+        constexpr bool is_alnum(char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        }
+
+        class Scanner {
+        public:
+            constexpr explicit Scanner(std::string_view source) : source(source) {}
+
+            // false when the source is over or when an error occurred.
+            constexpr bool next(Lexeme &out) {
+                while (!end()) {
+                    start = current;
+                    start_line = line;
+                    start_line_start = line_start;
+                    char c = advance();
+                    switch (c) {
+                        case '[':
+                            skip_until(']');
+                            if (end()) return fail(Scan_Error::UNCLOSED_SECTION);
+                            advance();
+                            out = lexeme(SECTION, source.substr(start + 1, current - start - 2));
+                            return true;
+                        case '"':
+                            skip_until('"');
+                            if (end()) return fail(Scan_Error::UNCLOSED_STRING);
+                            advance();
+                            out = lexeme(IDENTIFIER, source.substr(start + 1, current - start - 2));
+                            return true;
+                        case ':':
+                        case '=':
+                            out = lexeme(SEPARATOR, source.substr(start, current - start));
+                            return true;
+                        case ';':
+                        case '#':
+                            while (peek() != '\n' && !end()) advance();
+                            break;
+                        case ' ':
+                            // ignore.
+                            break;
+                        case '\n':
+                            new_line();
+                            break;
+                        default:
+                            if (is_alnum(c)) {
+                                while (is_alnum(peek()) || peek() == '.' || peek() == '_') advance();
+                                out = lexeme(IDENTIFIER, source.substr(start, current - start));
+                                return true;
+                            }
+
+                            return fail(Scan_Error::UNEXPECTED_CHARACTER);
+                    }
+                }
+                return false;
+            }
+
+            [[nodiscard]] constexpr Scan_Error get_error() const {
+                return error;
+            }
+
+            // position of the last scanned token, or of the error.
+            [[nodiscard]] constexpr int get_line() const {
+                return start_line;
+            }
+
+            [[nodiscard]] constexpr int get_column() const {
+                return static_cast<int>(start - start_line_start) + 1;
+            }
+
+            [[nodiscard]] constexpr char get_char() const {
+                return source[start];
+            }
+
+        private:
+            constexpr char advance() {
+                return source[current++];
+            }
+
+            constexpr char peek() const {
+                if (end()) return '\0';
+                return source[current];
+            }
+
+            constexpr void new_line() {
+                line++;
+                line_start = current;
+            }
+
+            // sections and quoted values may span lines.
+            constexpr void skip_until(char closing) {
+                while (peek() != closing && !end()) {
+                    if (advance() == '\n') new_line();
+                }
+            }
+
+            [[nodiscard]] constexpr bool end() const {
+                return current >= source.size();
+            }
+
+            constexpr Lexeme lexeme(ini_Token_Type type, std::string_view txt) const {
+                return Lexeme{type, txt, get_line(), get_column()};
+            }
+
+            constexpr bool fail(Scan_Error e) {
+                error = e;
+                return false;
+            }
+
+            std::string_view source;
+            Scan_Error error = Scan_Error::NONE;
+            int line = 1;
+            size_t line_start = 0;
+            int start_line = 1;
+            size_t start_line_start = 0;
+            size_t start = 0;
+            size_t current = 0;
+        };
+
+        enum class Parse_Error {
+            NONE,
+            MISSING_SEPARATOR,
+            MISSING_VALUE,
+            INVALID_KEY,
+            MISSING_PARENT_SECTION,
+            UNEXPECTED_TOKEN,
+            INSERTION_FAILED,
+        };
+
+        // lowercase, without empty segments: "Db..Opt." -> "db.opt".
+        constexpr std::string normalize_path(std::string_view path) {
+            std::string normalized;
+            size_t start = 0;
+            while (start <= path.size()) {
+                size_t dot = path.find('.', start);
+                if (dot == std::string_view::npos) dot = path.size();
+
+                if (dot > start) {
+                    if (!normalized.empty()) normalized.push_back('.');
+                    for (char c : path.substr(start, dot - start)) normalized.push_back(ascii_lower(c));
+                }
+                start = dot + 1;
+            }
+            return normalized;
+        }
+
+        // three-way comparison of an already normalized path with normalize_path(path), without allocating.
+        constexpr int path_compare(std::string_view normalized, std::string_view path) {
+            size_t at = 0;
+            bool emitted = false;
+            bool dot = false;
+            auto next = [&](char &c) {
+                while (at < path.size() && path[at] == '.') {
+                    dot = emitted;
+                    at++;
+                }
+                if (at == path.size()) return false;
+
+                if (dot) {
+                    dot = false;
+                    c = '.';
+                } else {
+                    c = ascii_lower(path[at++]);
+                    emitted = true;
+                }
+                return true;
+            };
+
+            char c;
+            for (char n : normalized) {
+                if (!next(c)) return 1;
+                if (n != c) return static_cast<unsigned char>(n) < static_cast<unsigned char>(c) ? -1 : 1;
+            }
+            return next(c) ? -1 : 0;
+        }
+
+        // works on any sequence of tokens exposing type and txt.
+        template<typename Tokens>
+        class Parser {
+        public:
+            constexpr explicit Parser(const Tokens &tokens) : tokens(tokens) {}
+
+            // sink(section_path, key, value) receives the normalized section path and the key as written,
+            // it returns false to stop the parsing.
+            template<typename Sink>
+            constexpr bool parse(Sink &&sink) {
+                while (current < tokens.size()) {
+                    if (!parse_token(sink)) return false;
+                }
+                return true;
+            }
+
+            [[nodiscard]] constexpr Parse_Error get_error() const {
+                return error;
+            }
+
+            // offending token, equal to the number of tokens when the source ended too early.
+            [[nodiscard]] constexpr size_t get_position() const {
+                return position;
+            }
+
+            // token the error refers to: the key, or the token found at position.
+            [[nodiscard]] constexpr size_t get_subject() const {
+                return subject;
+            }
+
+        private:
+            template<typename Sink>
+            constexpr bool parse_token(Sink &sink) {
+                size_t t = current++;
+                std::string_view txt = tokens[t].txt;
+                switch (tokens[t].type) {
+                    case IDENTIFIER: {
+                        if (!match(SEPARATOR)) return fail(Parse_Error::MISSING_SEPARATOR, current, t);
+                        current++;
+
+                        if (!match(IDENTIFIER)) return fail(Parse_Error::MISSING_VALUE, current, t);
+                        size_t v = current++;
+
+                        for (char c : txt) {
+                            if (c == ';' || c == '#' || c == '=' || c == ':' || c == ' ') {
+                                return fail(Parse_Error::INVALID_KEY, t, t);
+                            }
+                        }
+
+                        if (!sink(std::string_view(section_path), txt, std::string_view(tokens[v].txt))) {
+                            return fail(Parse_Error::INSERTION_FAILED, t, t);
+                        }
+                    }
+                        break;
+                    case SECTION:
+                        if (!txt.starts_with('.')) {
+                            section_path = normalize_path(txt);
+                            break;
+                        }
+
+                        if (section_path.empty()) return fail(Parse_Error::MISSING_PARENT_SECTION, t, t);
+                        section_path = normalize_path(section_path + std::string(txt));
+                        break;
+                    default:
+                        return fail(Parse_Error::UNEXPECTED_TOKEN, t, t);
+                }
+                return true;
+            }
+
+            [[nodiscard]] constexpr bool match(ini_Token_Type type) const {
+                return current < tokens.size() && tokens[current].type == type;
+            }
+
+            constexpr bool fail(Parse_Error e, size_t at, size_t about) {
+                error = e;
+                position = at;
+                subject = about;
+                return false;
+            }
+
+            const Tokens &tokens;
+            size_t current = 0;
+            std::string section_path;
+            Parse_Error error = Parse_Error::NONE;
+            size_t position = 0;
+            size_t subject = 0;
+        };
+    }
+
+    /*
+     * COMPILE-TIME PARSING:
+     *
+     * constexpr auto defaults = ini::parse<R"(
+     *     name = main
+     *     [Db]
+     *     port: 5432
+     * )">();
+     *
+     * std::string_view port = defaults.get_property("port", "Db");
+     *
+     * syntax errors are reported as compile errors.
+     */
+
+    template<size_t N>
+    struct fixed_string {
+        consteval fixed_string(const char (&str)[N]) {
+            std::copy_n(str, N, data);
+        }
+
+        [[nodiscard]] constexpr std::string_view view() const {
+            return {data, N - 1};
+        }
+
+        char data[N]{};
+    };
+
+    namespace detail {
+        struct Literal_Property {
+            std::string section;
+            std::string key;
+            std::string_view value;
+            // definition order, used to keep the first duplicate.
+            size_t order;
+        };
+
+        constexpr std::string &ascii_lower(std::string &str) {
+            for (auto &c : str) c = ascii_lower(c);
+            return str;
+        }
+
+        // errors are thrown to turn them into compile errors.
+        constexpr std::vector<Literal_Property> parse_literal(std::string_view source) {
+            std::vector<Lexeme> tokens;
+            Scanner scanner(source);
+            Lexeme lx;
+            while (scanner.next(lx)) tokens.push_back(lx);
+
+            switch (scanner.get_error()) {
+                case Scan_Error::NONE:
+                    break;
+                case Scan_Error::UNCLOSED_SECTION:
+                    throw "ini::parse: unclosed section definition";
+                case Scan_Error::UNCLOSED_STRING:
+                    throw "ini::parse: unclosed string definition";
+                case Scan_Error::UNEXPECTED_CHARACTER:
+                    throw "ini::parse: unexpected character";
+            }
+
+            std::vector<Literal_Property> props;
+            Parser parser(tokens);
+            bool result = parser.parse([&](std::string_view section, std::string_view key, std::string_view value) {
+                // same rule as ini::add_property.
+                if (key.empty() || value.empty()) return false;
+
+                std::string lowered(key);
+                props.push_back(Literal_Property{std::string(section), ascii_lower(lowered), value, props.size()});
+                return true;
+            });
+
+            if (!result) {
+                switch (parser.get_error()) {
+                    case Parse_Error::MISSING_SEPARATOR:
+                        throw "ini::parse: missing separator after key";
+                    case Parse_Error::MISSING_VALUE:
+                        throw "ini::parse: missing value after separator";
+                    case Parse_Error::INVALID_KEY:
+                        throw "ini::parse: invalid key identifier, use only alphanumeric characters";
+                    case Parse_Error::MISSING_PARENT_SECTION:
+                        throw "ini::parse: relative nesting is missing the parent section";
+                    case Parse_Error::INSERTION_FAILED:
+                        throw "ini::parse: empty key or value";
+                    default:
+                        throw "ini::parse: unexpected separator";
+                }
+            }
+
+            // the first definition wins, like ini::add_property.
+            std::sort(props.begin(), props.end(), [](const Literal_Property &a, const Literal_Property &b) {
+                if (a.section != b.section) return a.section < b.section;
+                if (a.key != b.key) return a.key < b.key;
+                return a.order < b.order;
+            });
+            auto last = std::unique(props.begin(), props.end(), [](const Literal_Property &a, const Literal_Property &b) {
+                return a.section == b.section && a.key == b.key;
+            });
+            props.erase(last, props.end());
+
+            return props;
+        }
+
+        struct Literal_Size {
+            size_t props;
+            size_t bytes;
+        };
+
+        constexpr Literal_Size measure_literal(std::string_view source) {
+            Literal_Size size{0, 0};
+            for (auto &p : parse_literal(source)) {
+                size.props++;
+                size.bytes += p.section.size() + p.key.size() + p.value.size();
+            }
+            return size;
+        }
+
+        struct Slice {
+            size_t offset = 0;
+            size_t length = 0;
+        };
+
+        struct Literal_Entry {
+            Slice section;
+            Slice key;
+            Slice value;
+        };
+    }
+
+    template<size_t N, size_t B>
+    class Table {
+    public:
+        constexpr explicit Table(const std::vector<detail::Literal_Property> &props) {
+            size_t used = 0;
+            auto store = [&](std::string_view txt) {
+                std::copy(txt.begin(), txt.end(), buffer.begin() + used);
+                detail::Slice slice{used, txt.size()};
+                used += txt.size();
+                return slice;
+            };
+
+            for (size_t i = 0; i < N; i++) {
+                entries[i].section = store(props[i].section);
+                entries[i].key = store(props[i].key);
+                entries[i].value = store(props[i].value);
+            }
+        }
+
+        [[nodiscard]] constexpr size_t size() const {
+            return N;
+        }
+
+        // entries are sorted by section path and key.
+        [[nodiscard]] constexpr Match at(size_t i) const {
+            return Match{view(entries[i].section), view(entries[i].key), view(entries[i].value)};
+        }
+
+        [[nodiscard]] constexpr bool contains(std::string_view key, std::string_view section_path = "") const {
+            return find(key, section_path) != N;
+        }
+
+        // this will throw std::out_of_range if the key does not exist.
+        [[nodiscard]] constexpr std::string_view get_property(std::string_view key, std::string_view section_path = "") const {
+            size_t i = find(key, section_path);
+            if (i == N) throw std::out_of_range("ini::Table::get_property: missing key '" + std::string(key) + "'");
+            return view(entries[i].value);
+        }
+
+    private:
+        [[nodiscard]] constexpr std::string_view view(detail::Slice slice) const {
+            return {buffer.data() + slice.offset, slice.length};
+        }
+
+        // binary search over the sorted entries, N if missing.
+        [[nodiscard]] constexpr size_t find(std::string_view key, std::string_view section_path) const {
+            size_t lo = 0;
+            size_t hi = N;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                int c = detail::path_compare(view(entries[mid].section), section_path);
+                if (c == 0) c = detail::icompare(view(entries[mid].key), key);
+                if (c == 0) return mid;
+
+                if (c < 0) lo = mid + 1;
+                else hi = mid;
+            }
+            return N;
+        }
+
+        std::array<detail::Literal_Entry, N> entries{};
+        std::array<char, B> buffer{};
+    };
+
+    template<fixed_string S>
+    consteval auto parse() {
+        constexpr detail::Literal_Size size = detail::measure_literal(S.view());
+        return Table<size.props, size.bytes>(detail::parse_literal(S.view()));
+    }
 }
 
+// global namespace scope only, see SCHEMA BINDING.
+#define INI_BIND(type, ...) \
+    template<> \
+    struct ini::Schema<type> { \
+        static constexpr auto binding = ini::bind<type>(__VA_ARGS__); \
+    }
+
 #endif //INIGER_H
@@ -0,0 +1,67 @@
+//
+// Created by Matteo Cardinaletti on 19/10/26.
+//
+#include "gtest/gtest.h"
+
+#include "../iniger.h"
+
+struct DbConfig {
+    std::string name;
+    std::string host;
+    int port = 0;
+    double timeout = 0;
+    bool verbose = false;
+    int retries = -1;
+};
+
+INI_BIND(DbConfig,
+         field(&DbConfig::name, "name"),
+         section("Db"),
+         field(&DbConfig::host, "host").required(),
+         field(&DbConfig::port, "port").or_default(5432),
+         section("Db.Options"),
+         field(&DbConfig::timeout, "timeout"),
+         field(&DbConfig::verbose, "Verbose").or_default(true),
+         field(&DbConfig::retries, "retries"));
+
+// the key table is sorted at compile time.
+static_assert(ini::Schema<DbConfig>::binding.get_table()[0].key == "name");
+static_assert(ini::Schema<DbConfig>::binding.get_table()[1].section == "Db");
+
+TEST(Binding, LoadTest) {
+    ini::Object ini("my_file.ini");
+    ini::add_property(ini, "name", "main");
+    ini::add_property(ini, "host", "localhost", "Db");
+    ini::add_property(ini, "timeout", "2.5", "Db.Options");
+    ini::add_property(ini, "unbound", "ignored", "Db.Options");
+    ini::add_property(ini, "host", "ignored", "Other");
+
+    DbConfig cfg;
+    ASSERT_EQ(true, ini::load(ini, cfg));
+    ASSERT_EQ("main", cfg.name);
+    ASSERT_EQ("localhost", cfg.host);
+    // defaulted fields take their value when missing
+    ASSERT_EQ(5432, cfg.port);
+    ASSERT_EQ(2.5, cfg.timeout);
+    ASSERT_EQ(true, cfg.verbose);
+    // optional fields are left untouched when missing
+    ASSERT_EQ(-1, cfg.retries);
+}
+
+TEST(Binding, RequiredTest) {
+    ini::Object ini("my_file.ini");
+    ini::add_property(ini, "port", "1234", "Db");
+    const ini::Object &view = ini;
+
+    DbConfig cfg;
+    ASSERT_EQ(false, ini::load(view, cfg));
+}
+
+TEST(Binding, ConversionTest) {
+    ini::Object ini("my_file.ini");
+    ini::add_property(ini, "host", "localhost", "Db");
+    ini::add_property(ini, "port", "not_a_number", "Db");
+
+    DbConfig cfg;
+    ASSERT_EQ(false, ini::load(ini, cfg));
+}
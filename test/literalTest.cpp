@@ -0,0 +1,75 @@
+//
+// Created by Matteo Cardinaletti on 19/10/26.
+//
+#include "gtest/gtest.h"
+
+#include <fstream>
+
+#include "../iniger.h"
+
+constexpr auto defaults = ini::parse<R"(
+; comments are ignored
+Name = main
+
+[Db]
+Host: "local host"
+port = 5432
+port = 1234
+
+[.Options]
+timeout = 2.5
+
+# absolute sections reset the path
+[Cache]
+size: 64
+)">();
+
+static_assert(defaults.size() == 5);
+static_assert(defaults.get_property("name") == "main");
+// keys and section paths are case-insensitive
+static_assert(defaults.get_property("HOST", "db") == "local host");
+// the first definition wins
+static_assert(defaults.get_property("port", "Db") == "5432");
+static_assert(defaults.get_property("timeout", "Db.Options") == "2.5");
+static_assert(defaults.contains("size", "Cache"));
+static_assert(!defaults.contains("size", "Db"));
+
+constexpr auto empty = ini::parse<"">();
+static_assert(empty.size() == 0);
+
+TEST(Literal, LookupTest) {
+    ASSERT_EQ("64", defaults.get_property("size", "Cache"));
+    ASSERT_EQ(false, defaults.contains("missing"));
+    ASSERT_THROW((void) defaults.get_property("missing"), std::out_of_range);
+}
+
+// empty path segments are dropped by both front ends
+constexpr ini::fixed_string agreement_source =
+        "Name = main\n[Db.]\nk = v\n[.Opt]\nt = 1\n[..Deep..Path.]\nkey: \"spaced value\"\nKEY = ignored\n";
+
+constexpr auto agreement = ini::parse<agreement_source>();
+
+static_assert(agreement.contains("k", "Db"));
+static_assert(agreement.contains("t", "Db.Opt"));
+static_assert(agreement.contains("key", "db.opt.deep.path"));
+// lookup paths follow the same rules as get_property
+static_assert(agreement.contains("k", "Db."));
+static_assert(agreement.contains("t", ".DB..opt"));
+static_assert(agreement.get_property("key", "Db.Opt..Deep.Path.") == "spaced value");
+static_assert(!agreement.contains("k", "Db.Opt"));
+static_assert(!agreement.contains("k", "D.b"));
+static_assert(agreement.contains("name", "."));
+
+TEST(Literal, AgreementTest) {
+    // same source through the runtime reader
+    std::ofstream("literal_test.ini") << agreement_source.view();
+    ini::Object ini("literal_test.ini");
+    ASSERT_EQ(true, ini::read(ini));
+
+    auto matches = ini::query(ini, "**.*");
+    ASSERT_EQ(agreement.size(), matches.size());
+    for (size_t i = 0; i < agreement.size(); i++) {
+        ini::Match m = agreement.at(i);
+        ASSERT_EQ(m.value, ini::get_property(ini, std::string(m.key), std::string(m.path)));
+    }
+}
@@ -0,0 +1,77 @@
+//
+// Created by Matteo Cardinaletti on 19/10/26.
+//
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "../iniger.h"
+
+// live heap bytes of this test binary, counted by the replaced global allocator.
+// it lives in its own executable (inigerMemoryTest) to leave the other suites untouched.
+static std::atomic<size_t> live_bytes = 0;
+
+void *operator new(size_t size) {
+    // the header keeps the size for operator delete, aligned as max_align_t.
+    auto *block = static_cast<unsigned char *>(std::malloc(size + alignof(std::max_align_t)));
+    if (!block) throw std::bad_alloc();
+    *reinterpret_cast<size_t *>(block) = size;
+    live_bytes += size;
+    return block + alignof(std::max_align_t);
+}
+
+void operator delete(void *ptr) noexcept {
+    if (!ptr) return;
+    auto *block = static_cast<unsigned char *>(ptr) - alignof(std::max_align_t);
+    live_bytes -= *reinterpret_cast<size_t *>(block);
+    std::free(block);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+static void fill(ini::Object &ini) {
+    ini::add_property(ini, "name", "a value long enough to leave the small string buffer");
+    ini::add_property(ini, "short", "value");
+    for (int i = 0; i < 32; i++) {
+        ini::add_property(ini, "key_" + std::to_string(i), "another value long enough for the heap", "Foo.Bar");
+    }
+    ini::add_property(ini, "a_long_key_that_needs_the_heap", "value", "Baz");
+}
+
+TEST(Memory, UsageTest) {
+    size_t before = live_bytes;
+    {
+        ini::Object ini("a_file_path_long_enough_to_need_the_heap.ini");
+        fill(ini);
+        size_t allocated = live_bytes - before;
+
+        ini::MemoryUsage usage = ini::memory_usage(ini);
+        ASSERT_EQ(allocated, usage.total());
+        ASSERT_EQ(4, usage.sections.size());
+        // 31 copies of the same value inside 'foo.bar'
+        ASSERT_LT(0, usage.duplicate_values);
+    }
+    ASSERT_EQ(before, live_bytes);
+}
+
+TEST(Memory, CompactTest) {
+    ini::Object ini("my_file.ini");
+    fill(ini);
+    ini::get_property(ini, "name").reserve(1024);
+    // removed properties leave their buckets behind
+    for (int i = 0; i < 512; i++) ini::add_property(ini, "extra_" + std::to_string(i), "value", "Foo.Bar");
+    for (int i = 0; i < 512; i++) ini::remove_property(ini, "extra_" + std::to_string(i), "Foo.Bar");
+
+    size_t before = live_bytes;
+    size_t reported = ini::memory_usage(ini).total();
+    ini::compact(ini);
+    size_t after = live_bytes;
+
+    ASSERT_LT(after, before);
+    ASSERT_EQ(reported - (before - after), ini::memory_usage(ini).total());
+    ASSERT_EQ("another value long enough for the heap", ini::get_property(ini, "key_7", "Foo.Bar"));
+}
@@ -0,0 +1,161 @@
+//
+// Created by Matteo Cardinaletti on 19/10/26.
+//
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#include "../iniger.h"
+
+static std::vector<std::string> paths(const std::vector<ini::Match> &matches) {
+    std::vector<std::string> v;
+    for (auto &m : matches) v.emplace_back(m.path);
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+// sections are changed through the ini functions only.
+static_assert(std::is_const_v<std::remove_reference_t<decltype(std::declval<ini::Section &>().get_props())>>);
+static_assert(std::is_const_v<std::remove_reference_t<decltype(std::declval<ini::Section &>().get_subsecs())>>);
+
+class QueryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ini::add_property(ini, "port", "80");
+        ini::add_property(ini, "port", "8080", "Servers");
+        ini::add_property(ini, "port", "1001", "Servers.EU1");
+        ini::add_property(ini, "host", "eu1.example", "Servers.EU1");
+        ini::add_property(ini, "port", "1002", "Servers.EU2");
+        ini::add_property(ini, "port", "1003", "Servers.EU2.Backup");
+        ini::add_property(ini, "port", "2001", "Clients.US1");
+    }
+
+    ini::Object ini = ini::Object("my_file.ini");
+};
+
+TEST_F(QueryTest, SingleWildcardTest) {
+    auto matches = ini::query(ini, "servers.*.port");
+    ASSERT_EQ((std::vector<std::string>{"servers.eu1", "servers.eu2"}), paths(matches));
+    for (auto &m : matches) ASSERT_EQ("port", m.key);
+}
+
+TEST_F(QueryTest, DoubleWildcardTest) {
+    // '**' matches zero segments as well
+    auto matches = ini::query(ini, "Servers.**.port");
+    ASSERT_EQ((std::vector<std::string>{"servers", "servers.eu1", "servers.eu2", "servers.eu2.backup"}),
+              paths(matches));
+
+    ASSERT_EQ(7, ini::query(ini, "**.port").size() + ini::query(ini, "**.host").size());
+}
+
+TEST_F(QueryTest, TrailingWildcardTest) {
+    // a trailing '**' matches every key at any depth
+    ASSERT_EQ((std::vector<std::string>{"servers", "servers.eu1", "servers.eu1", "servers.eu2", "servers.eu2.backup"}),
+              paths(ini::query(ini, "servers.**")));
+    ASSERT_EQ(7, ini::query(ini, "**").size());
+
+    // a trailing '*' only matches the keys of the sections matched so far
+    ASSERT_EQ((std::vector<std::string>{"servers.eu1", "servers.eu1", "servers.eu2"}),
+              paths(ini::query(ini, "servers.*.*")));
+    ASSERT_EQ(1, ini::query(ini, "*").size());
+    ASSERT_EQ(0, ini::query(ini, "missing.*").size());
+}
+
+TEST_F(QueryTest, LiteralTest) {
+    auto matches = ini::query(ini, "servers.eu1.host");
+    ASSERT_EQ(1, matches.size());
+    ASSERT_EQ("eu1.example", matches[0].value);
+
+    // without a path only the global section is searched
+    matches = ini::query(ini, "port");
+    ASSERT_EQ(1, matches.size());
+    ASSERT_EQ("80", matches[0].value);
+
+    ASSERT_EQ(0, ini::query(ini, "servers.*.missing").size());
+    ASSERT_EQ(2, ini::query(ini, "servers.eu1.*").size());
+}
+
+TEST_F(QueryTest, CopyTest) {
+    ini::Object copy = ini;
+    ini::get_property(copy, "port", "Servers.EU1") = "9999";
+
+    // the copy has its own index
+    ASSERT_EQ("9999", ini::query(copy, "servers.eu1.port")[0].value);
+    ASSERT_EQ("1001", ini::query(ini, "servers.eu1.port")[0].value);
+}
+
+TEST_F(QueryTest, RemovedSectionTest) {
+    ini::add_property(ini, "port", "a value long enough to leave the small string buffer", "Servers.EU3");
+    ASSERT_EQ(3, ini::query(ini, "servers.*.port").size());
+    ASSERT_EQ(true, ini::remove_section(ini, "EU3", "Servers"));
+    ASSERT_EQ(false, ini::remove_section(ini, "EU3", "Servers"));
+
+    ASSERT_EQ((std::vector<std::string>{"servers.eu1", "servers.eu2"}), paths(ini::query(ini, "servers.*.port")));
+}
+
+TEST_F(QueryTest, RemovedPropertyTest) {
+    ASSERT_EQ(true, ini::remove_property(ini, "PORT", "Servers.EU1"));
+    ASSERT_EQ(false, ini::remove_property(ini, "port", "Servers.Missing"));
+
+    ASSERT_EQ((std::vector<std::string>{"servers.eu2"}), paths(ini::query(ini, "servers.*.port")));
+    ASSERT_EQ(1, ini::query(ini, "servers.eu1.*").size());
+}
+
+TEST_F(QueryTest, SectionInsertionTest) {
+    auto before = ini::query(ini, "*.*.port");
+    ini::add_section(ini, "Clients");
+    ini::add_property(ini::get_section(ini, "US1", "Clients"), "host", "us1.example");
+
+    auto matches = ini::query(ini, "*.*.host");
+    ASSERT_EQ((std::vector<std::string>{"clients.us1", "servers.eu1"}), paths(matches));
+
+    // the rebuilt index doesn't own the paths of earlier matches
+    ASSERT_EQ((std::vector<std::string>{"clients.us1", "servers.eu1", "servers.eu2"}), paths(before));
+}
+
+TEST_F(QueryTest, OtherObjectTest) {
+    ini::Object other("other.ini");
+    uint64_t version = ini.get_version();
+
+    ini::add_section(other, "A");
+    ini::add_property(ini::get_section(other, "A"), "key", "value");
+    ASSERT_EQ(version, ini.get_version());
+    ASSERT_NE(0, other.get_version());
+
+    // reading a section doesn't count as a change
+    (void) ini::get_section(ini, "Servers").get_props();
+    ASSERT_EQ(version, ini.get_version());
+}
+
+TEST_F(QueryTest, MoveTest) {
+    ini::Object moved = std::move(ini);
+    ini::add_property(ini::get_section(moved, "EU2", "Servers"), "host", "eu2.example");
+
+    ASSERT_EQ((std::vector<std::string>{"servers.eu1", "servers.eu2"}), paths(ini::query(moved, "servers.*.host")));
+    ASSERT_EQ(1, ini::query(moved, "port").size());
+}
+
+TEST_F(QueryTest, DottedKeyTest) {
+    ini::add_property(ini, "a.b", "dotted", "S");
+    ini::add_property(ini, "b", "nested", "S.A");
+    ASSERT_EQ("dotted", ini::get_property(ini, "a.b", "S"));
+
+    // both readings of 's.a.b' match
+    ASSERT_EQ((std::vector<std::string>{"s", "s.a"}), paths(ini::query(ini, "s.a.b")));
+    ASSERT_EQ(2, ini::query(ini, "*.a.b").size());
+    // a literal key never matches part of a dotted key
+    ASSERT_EQ(1, ini::query(ini, "**.b").size());
+}
+
+TEST_F(QueryTest, SectionPathTest) {
+    ini::add_property(ini, "other", "value", "Servers.EU1");
+
+    // the index points to sections, paths are stored once inside them
+    ASSERT_EQ(6, ini.get_index().keys.at("port").size());
+    ASSERT_EQ(ini.get_index().keys.at("host")[0], ini.get_index().keys.at("other")[0]);
+
+    const ini::Section &eu1 = ini::get_section(ini, "EU1", "Servers");
+    ASSERT_EQ("servers.eu1", eu1.get_path());
+    ASSERT_EQ(eu1.get_path().data(), ini::query(ini, "*.eu1.other")[0].path.data());
+}
@@ -25,4 +25,48 @@ TEST(ReadWrite, ReadingTest) {
     ini::Object ini("../../test/reading_test.ini");
     bool result = ini::read(ini);
     ASSERT_EQ(true, result);
-}
\ No newline at end of file
+}
+
+TEST(ReadWrite, ReadingStatsTest) {
+    ini::ReadStats stats;
+    ini::Object ini = ini::read("../../test/reading_test.ini", stats);
+    ASSERT_EQ(ini::Error_Code::NONE, stats.error.code);
+    ASSERT_EQ(7, stats.tokens);
+    ASSERT_EQ(1, stats.sections);
+    ASSERT_EQ(2, stats.properties);
+    ASSERT_LT(0, stats.bytes_read);
+    ASSERT_LE(stats.insert_time, stats.parse_time);
+    ASSERT_EQ("foo_value", ini::get_property(ini, "foo_key", "Foo"));
+
+    // only what the reading creates is counted
+    size_t allocated = stats.estimated_allocated_bytes;
+    ini::read(ini, stats);
+    ASSERT_EQ(0, stats.sections);
+    ASSERT_EQ(0, stats.properties);
+    ASSERT_GT(allocated, stats.estimated_allocated_bytes);
+}
+
+TEST(ReadWrite, ReadingErrorTest) {
+    ini::ReadStats stats;
+    ini::Object ini("../../test/error_test.ini");
+    bool result = ini::read(ini, stats);
+    ASSERT_EQ(false, result);
+    ASSERT_EQ(ini::Error_Code::UNEXPECTED_CHARACTER, stats.error.code);
+    ASSERT_EQ(4, stats.error.line);
+    ASSERT_EQ(20, stats.error.column);
+
+    ini.set_file_path("missing.txt");
+    result = ini::read(ini, stats);
+    ASSERT_EQ(false, result);
+    ASSERT_EQ(ini::Error_Code::BAD_EXTENSION, stats.error.code);
+}
+
+TEST(ReadWrite, MultilineErrorTest) {
+    ini::ReadStats stats;
+    ini::Object ini("../../test/multiline_error_test.ini");
+    ASSERT_EQ(false, ini::read(ini, stats));
+    ASSERT_EQ(ini::Error_Code::UNEXPECTED_CHARACTER, stats.error.code);
+    // the quoted value spans lines 2 and 3
+    ASSERT_EQ(5, stats.error.line);
+    ASSERT_EQ(8, stats.error.column);
+}